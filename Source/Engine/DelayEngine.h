@@ -0,0 +1,399 @@
+/*
+  ==============================================================================
+
+    DelayEngine.h
+    Created: 19 Oct 2026
+    Author:  David Jones
+
+    The whole EZ DLay signal path with no JUCE dependency. The plugin is a
+    thin wrapper around this class, and ezdlay.h exposes it to C, so every
+    host runs the same code. Buffers are owned by the caller and processed
+    in place or out of place, planar or interleaved, without copying.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "GrainScheduler.h"
+#include "QualityGovernor.h"
+#include "DspUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined (__SSE__) || defined (_M_X64) || defined (_M_IX86)
+ #include <xmmintrin.h>
+#endif
+
+//===================================================================================
+class DelayEngine
+{
+public:
+    static constexpr float maxDelayTimeMs = 2000.0f;
+
+    //==============================================================================
+    // Allocates everything the engine needs; process() never allocates.
+    void prepare (double newSampleRate, int maxBlockSize)
+    {
+        sampleRate = newSampleRate;
+        bufferLength = std::max (1, (int) (sampleRate * (maxDelayTimeMs / 1000)));
+        delayBufferLeft.assign ((size_t) bufferLength, 0.0f);
+        delayBufferRight.assign ((size_t) bufferLength, 0.0f);
+
+        governor.prepare (sampleRate, maxBlockSize);
+        modeFadeStep = (float) (1.0 / (sampleRate * 0.02));
+        grains.prepare (sampleRate, bufferLength, (int) std::ceil (1.0f / modeFadeStep) + 1);
+        cutoffSmoothing = (float) (1.0 - std::exp (-1.0 / (sampleRate * 0.02)));
+
+        reset();
+    }
+
+    // Clears the delay line and filter state without reallocating.
+    void reset()
+    {
+        std::fill (delayBufferLeft.begin(), delayBufferLeft.end(), 0.0f);
+        std::fill (delayBufferRight.begin(), delayBufferRight.end(), 0.0f);
+        bufferWriteHead = 0;
+        feedbackLeft = 0;
+        feedbackRight = 0;
+
+        delayTimeSmoothed = delayTime / 1000;
+        delayTimeSamples = (float) sampleRate * delayTimeSmoothed;
+
+        filterL.reset();
+        filterR.reset();
+        filterCutoff = cutoff;
+        smoothedCutoff = cutoff;
+        filterUpdateCounter = 0;
+        updateFilters();
+
+        grains.reset();
+        granularGain = grains.getMode() == GrainScheduler::Normal ? 0.0f : 1.0f;
+        freezeWriteGain = grains.getMode() == GrainScheduler::Freeze ? 0.0f : 1.0f;
+    }
+
+    bool isPrepared() const  { return bufferLength > 1; }
+
+    //==============================================================================
+    void setDelayTime (float milliseconds)  { delayTime = limitValue (0.0f, maxDelayTimeMs, milliseconds); }
+    void setFeedback (float newFeedback)     { feedback = limitValue (0.0f, 0.98f, newFeedback); }
+    void setMix (float newMix)               { mix = limitValue (0.0f, 1.0f, newMix); }
+    void setCutoff (float frequency)         { cutoff = limitValue (20.0f, 20000.0f, frequency); }
+    void setQualityMode (int newMode)        { governor.setMode (newMode); }
+    void setMode (int newMode)               { grains.setMode (newMode); }
+    void setNonRealtime (bool shouldBeNonRealtime)  { governor.setNonRealtime (shouldBeNonRealtime); }
+
+    int getQualityTier() const  { return governor.getTier(); }
+    float getCpuLoad() const    { return governor.getLoad(); }
+
+    //==============================================================================
+    // Mono or stereo. stride is the distance between consecutive frames, so 1
+    // for planar buffers and the channel count for interleaved ones. The right
+    // pointers may be null for mono; output may alias input.
+    void process (const float* inL, const float* inR, float* outL, float* outR, int stride, int numSamples)
+    {
+        if (! isPrepared() || numSamples <= 0)
+            return;
+
+        ScopedFlushToZero flushToZero;
+        governor.blockStarted();
+
+        if (inR == nullptr)
+            inR = inL;
+
+        const int tier = governor.getTier();
+        const int previousTier = governor.getPreviousTier();
+        const int filterUpdateInterval = QualityGovernor::getFilterUpdateInterval (tier);
+        grains.setDensityDivider (QualityGovernor::getGrainDensityDivider (tier));
+
+        const int mode = grains.getMode();
+        const float granularTarget = mode == GrainScheduler::Normal ? 0.0f : 1.0f;
+        const float freezeTarget = mode == GrainScheduler::Freeze ? 0.0f : 1.0f;
+        const float* delayBuffers[] = { delayBufferLeft.data(), delayBufferRight.data() };
+        float* grainOutputs[] = { grainBufferLeft, grainBufferRight };
+        float* delayLeft = delayBufferLeft.data();
+        float* delayRight = delayBufferRight.data();
+        int grainChunkStart = 0;
+        int grainChunkEnd = 0;
+
+        for (int sample = 0; sample < numSamples; sample++)
+        {
+            // Grains are rendered a chunk at a time ahead of the per-sample loop,
+            // which is safe because they always trail the write head by at least a chunk
+            if (sample == grainChunkEnd)
+            {
+                grainChunkStart = sample;
+                grainChunkEnd = sample + limitValue (0, GrainScheduler::maxChunkSize, numSamples - sample);
+                if (grains.isActive())
+                    grains.process (delayBuffers, bufferWriteHead, (int) delayTimeSamples, grainOutputs, grainChunkEnd - grainChunkStart);
+                else
+                {
+                    std::fill (std::begin (grainBufferLeft), std::end (grainBufferLeft), 0.0f);
+                    std::fill (std::begin (grainBufferRight), std::end (grainBufferRight), 0.0f);
+                }
+            }
+
+            // The cutoff glides over about 20 ms so moving it doesn't zipper. While it
+            // glides, recomputing the coefficients (a tan and a divide) is the most
+            // expensive thing in this loop, so lower tiers only do it every few samples.
+            if (smoothedCutoff != cutoff)
+            {
+                smoothedCutoff += cutoffSmoothing * (cutoff - smoothedCutoff);
+                if (std::abs (cutoff - smoothedCutoff) < 0.1f)
+                    smoothedCutoff = cutoff;
+            }
+
+            if (filterUpdateCounter <= 0)
+            {
+                if (smoothedCutoff != filterCutoff)
+                {
+                    filterCutoff = smoothedCutoff;
+                    updateFilters();
+                }
+                filterUpdateCounter = filterUpdateInterval;
+            }
+            filterUpdateCounter--;
+
+            delayTimeSmoothed = delayTimeSmoothed - .0001f * (delayTimeSmoothed - (delayTime / 1000));
+            delayTimeSamples = (float) sampleRate * delayTimeSmoothed;
+
+            const float inputLeft = inL[sample * stride];
+            const float inputRight = inR[sample * stride];
+
+            // Freeze fades the writes out rather than cutting them, then parks the write head
+            if (freezeWriteGain != freezeTarget)
+                freezeWriteGain = limitValue (0.0f, 1.0f, freezeWriteGain + (freezeTarget > freezeWriteGain ? modeFadeStep : -modeFadeStep));
+
+            if (freezeWriteGain >= 1)
+            {
+                delayRight[bufferWriteHead] = inputRight + feedbackRight;
+                delayLeft[bufferWriteHead] = inputLeft + feedbackLeft;
+            }
+            else if (freezeWriteGain > 0)
+            {
+                delayRight[bufferWriteHead] = lerp (delayRight[bufferWriteHead], inputRight + feedbackRight, freezeWriteGain);
+                delayLeft[bufferWriteHead] = lerp (delayLeft[bufferWriteHead], inputLeft + feedbackLeft, freezeWriteGain);
+            }
+
+            delayReadHead = bufferWriteHead - delayTimeSamples;
+
+            if (delayReadHead < 0)
+                delayReadHead += bufferLength;
+
+            if (granularGain != granularTarget)
+                granularGain = limitValue (0.0f, 1.0f, granularGain + (granularTarget > granularGain ? modeFadeStep : -modeFadeStep));
+
+            // The tier crossfade advances every sample, even while the grains cover
+            // the interpolated read, or the governor could never change tier again
+            const bool tierFading = governor.isFading();
+            const float tierFadeGain = tierFading ? governor.getNextFadeGain() : 1.0f;
+
+            float delaySampleLeft = 0, delaySampleRight = 0;
+            if (granularGain < 1)
+            {
+                readDelaySamples (tier, delaySampleLeft, delaySampleRight);
+
+                // Crossfade out of the previous tier's interpolation after a tier change
+                if (tierFading)
+                {
+                    float previousLeft, previousRight;
+                    readDelaySamples (previousTier, previousLeft, previousRight);
+                    delaySampleLeft = lerp (previousLeft, delaySampleLeft, tierFadeGain);
+                    delaySampleRight = lerp (previousRight, delaySampleRight, tierFadeGain);
+                }
+            }
+            if (granularGain > 0)
+            {
+                int grainIndex = sample - grainChunkStart;
+                delaySampleLeft = lerp (delaySampleLeft, grainBufferLeft[grainIndex], granularGain);
+                delaySampleRight = lerp (delaySampleRight, grainBufferRight[grainIndex], granularGain);
+            }
+
+            float delaySampleLowPassL = filterL.process (delaySampleLeft);
+            float delaySampleLowPassR = filterR.process (delaySampleRight);
+
+            feedbackLeft = feedback * delaySampleLowPassL;
+            feedbackRight = feedback * delaySampleLowPassR;
+
+            if (freezeWriteGain > 0)
+                bufferWriteHead++;
+
+            outL[sample * stride] = inputLeft * (1 - mix) + delaySampleLowPassL * mix;
+            if (outR != nullptr)
+                outR[sample * stride] = inputRight * (1 - mix) + delaySampleLowPassR * mix;
+
+            if (bufferWriteHead >= bufferLength)
+                bufferWriteHead = 0;
+        }
+
+        governor.blockFinished (numSamples);
+    }
+
+    // One pointer per channel. in and out may be the same arrays.
+    bool processPlanar (const float* const* in, float* const* out, int numChannels, int numSamples)
+    {
+        if (numChannels == 1)
+            process (in[0], nullptr, out[0], nullptr, 1, numSamples);
+        else if (numChannels == 2)
+            process (in[0], in[1], out[0], out[1], 1, numSamples);
+        else
+            return false;
+        return true;
+    }
+
+    // Frames of numChannels samples back to back. in and out may be the same buffer.
+    bool processInterleaved (const float* in, float* out, int numChannels, int numSamples)
+    {
+        if (numChannels == 1)
+            process (in, nullptr, out, nullptr, 1, numSamples);
+        else if (numChannels == 2)
+            process (in, in + 1, out, out + 1, 2, numSamples);
+        else
+            return false;
+        return true;
+    }
+
+    //==============================================================================
+    static float lerp (float sample1, float sample2, float inPhase)
+    {
+        return (1 - inPhase) * sample1 + inPhase * sample2;
+    }
+
+    // 4-point Hermite, interpolates between sample0 and sample1
+    static float cubic (float sampleM1, float sample0, float sample1, float sample2, float inPhase)
+    {
+        float c1 = 0.5f * (sample1 - sampleM1);
+        float c2 = sampleM1 - 2.5f * sample0 + 2.0f * sample1 - 0.5f * sample2;
+        float c3 = 0.5f * (sample2 - sampleM1) + 1.5f * (sample0 - sample1);
+        return ((c3 * inPhase + c2) * inPhase + c1) * inPhase + sample0;
+    }
+
+private:
+    //==============================================================================
+    // Second order Butterworth lowpass, same response and topology as the
+    // juce::IIRFilter / IIRCoefficients::makeLowPass pair it replaces.
+    struct Lowpass
+    {
+        void setCutoff (double sampleRate, double frequency)
+        {
+            const double n = 1.0 / std::tan (3.141592653589793 * frequency / sampleRate);
+            const double nSquared = n * n;
+            const double invQ = std::sqrt (2.0);
+            const double c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+            b0 = (float) c1;
+            b1 = (float) (c1 * 2.0);
+            b2 = (float) c1;
+            a1 = (float) (c1 * 2.0 * (1.0 - nSquared));
+            a2 = (float) (c1 * (1.0 - invQ * n + nSquared));
+        }
+
+        void reset()  { v1 = v2 = 0; }
+
+        float process (float in)
+        {
+            float out = b0 * in + v1;
+            v1 = b1 * in - a1 * out + v2;
+            v2 = b2 * in - a2 * out;
+            return out;
+        }
+
+        float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+        float v1 = 0, v2 = 0;
+    };
+
+    // Denormals in the feedback path are expensive, so flush them for the block
+    struct ScopedFlushToZero
+    {
+       #if defined (__SSE__) || defined (_M_X64) || defined (_M_IX86)
+        ScopedFlushToZero() : previous (_mm_getcsr())  { _mm_setcsr (previous | 0x8040); }
+        ~ScopedFlushToZero()                           { _mm_setcsr (previous); }
+        unsigned int previous;
+       #elif defined (__aarch64__)
+        ScopedFlushToZero()
+        {
+            asm volatile ("mrs %0, fpcr" : "=r" (previous));
+            asm volatile ("msr fpcr, %0" : : "r" (previous | (1ull << 24)));
+        }
+        ~ScopedFlushToZero()  { asm volatile ("msr fpcr, %0" : : "r" (previous)); }
+        unsigned long long previous;
+       #endif
+    };
+
+    void updateFilters()
+    {
+        filterL.setCutoff (sampleRate, filterCutoff);
+        filterR.setCutoff (sampleRate, filterCutoff);
+    }
+
+    void readDelaySamples (int tier, float& left, float& right) const
+    {
+        const float* delayLeft = delayBufferLeft.data();
+        const float* delayRight = delayBufferRight.data();
+
+        int readHeadInt = (int) delayReadHead;
+        float readHeadFloat = delayReadHead - readHeadInt;
+
+        // A read head just below zero wraps to bufferLength once rounded to float
+        if (readHeadInt >= bufferLength)
+            readHeadInt -= bufferLength;
+
+        int readHeadInt1 = readHeadInt + 1;
+        if (readHeadInt1 >= bufferLength)
+            readHeadInt1 -= bufferLength;
+
+        if (! QualityGovernor::usesCubicInterpolation (tier))
+        {
+            left = lerp (delayLeft[readHeadInt], delayLeft[readHeadInt1], readHeadFloat);
+            right = lerp (delayRight[readHeadInt], delayRight[readHeadInt1], readHeadFloat);
+            return;
+        }
+
+        int readHeadIntM1 = readHeadInt - 1;
+        int readHeadInt2 = readHeadInt1 + 1;
+
+        if (readHeadIntM1 < 0)
+            readHeadIntM1 += bufferLength;
+        if (readHeadInt2 >= bufferLength)
+            readHeadInt2 -= bufferLength;
+
+        left = cubic (delayLeft[readHeadIntM1], delayLeft[readHeadInt], delayLeft[readHeadInt1], delayLeft[readHeadInt2], readHeadFloat);
+        right = cubic (delayRight[readHeadIntM1], delayRight[readHeadInt], delayRight[readHeadInt1], delayRight[readHeadInt2], readHeadFloat);
+    }
+
+    //==============================================================================
+    double sampleRate = 44100;
+
+    float delayTime = 200;
+    float feedback = 0.5f;
+    float mix = 0.5f;
+    float cutoff = 20000;
+
+    std::vector<float> delayBufferLeft;
+    std::vector<float> delayBufferRight;
+    int bufferWriteHead = 0;
+    int bufferLength = 0;
+    float delayTimeSmoothed = 0;
+    float delayTimeSamples = 0;
+    float delayReadHead = 0;
+    float feedbackLeft = 0;
+    float feedbackRight = 0;
+
+    Lowpass filterL;
+    Lowpass filterR;
+    float filterCutoff = 20000;
+    float smoothedCutoff = 20000;
+    float cutoffSmoothing = 1;
+    int filterUpdateCounter = 0;
+
+    QualityGovernor governor;
+
+    GrainScheduler grains;
+    float grainBufferLeft[GrainScheduler::maxChunkSize] = {};
+    float grainBufferRight[GrainScheduler::maxChunkSize] = {};
+    float granularGain = 0;
+    float freezeWriteGain = 1;
+    float modeFadeStep = 1;
+};
@@ -0,0 +1,22 @@
+/*
+  ==============================================================================
+
+    DspUtils.h
+    Created: 19 Oct 2026
+    Author:  David Jones
+
+    Small helpers shared by the engine headers. The engine is built as
+    C++14 with the plugin, so std::clamp isn't available.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Same argument order as juce::jlimit. Takes its arguments by value, so
+// passing a static constexpr member doesn't need an out-of-line definition.
+template <typename Type>
+inline Type limitValue (Type lowerLimit, Type upperLimit, Type value)
+{
+    return value < lowerLimit ? lowerLimit : (upperLimit < value ? upperLimit : value);
+}
@@ -0,0 +1,382 @@
+/*
+  ==============================================================================
+
+    GrainScheduler.h
+    Created: 19 Oct 2026
+    Author:  David Jones
+
+    Reads Hann-windowed grains out of the delay buffer for the reverse,
+    freeze and scatter modes. Everything is sized in prepare(): the grain
+    pool is a fixed array, so process() never allocates or locks.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "DspUtils.h"
+
+#if defined (__SSE__) || defined (_M_X64) || defined (_M_IX86)
+ #include <xmmintrin.h>
+ #define EZDLAY_GRAIN_SSE 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define EZDLAY_GRAIN_NEON 1
+#endif
+
+//===================================================================================
+class GrainScheduler
+{
+public:
+    enum Mode
+    {
+        Normal = 0,     // plain delay line, no grains
+        Reverse,        // back-to-back reversed grains trailing the delay time
+        Freeze,         // buffer writes stop, grains loop the last delay time
+        Scatter,        // dense short grains at random positions behind the delay time
+        numModes
+    };
+
+    static const char* const* getModeNames()
+    {
+        static const char* const names[numModes] = { "Normal", "Reverse", "Freeze", "Scatter" };
+        return names;
+    }
+
+    static constexpr int numChannels = 2;
+    static constexpr int maxGrains = 64;        // per channel
+    static constexpr int maxChunkSize = 256;    // also the shortest delay a grain can trail by
+
+    //==============================================================================
+    // writeFadeLength is how many samples the caller keeps writing, fading out,
+    // after freeze starts; freeze grains stay clear of them.
+    void prepare (double sampleRate, int delayBufferLength, int writeFadeLength)
+    {
+        bufferLength = delayBufferLength;
+        freezeWriteFadeLength = writeFadeLength;
+
+        // Reverse and freeze use long grains, scatter short ones; each gets its own table
+        fillHannWindow (longWindow, (int) (sampleRate * 0.25));
+        fillHannWindow (shortWindow, (int) (sampleRate * 0.05));
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& pool : grains)
+            for (auto& grain : pool)
+                grain.active = false;
+
+        for (auto& countdown : samplesUntilNextGrain)
+            countdown = 0;
+
+        for (auto& priming : needsPriming)
+            priming = false;
+
+        numActiveGrains = 0;
+        anchorValid = false;
+    }
+
+    void setMode (int newMode)
+    {
+        newMode = limitValue ((int) Normal, (int) Scatter, newMode);
+        if (newMode != mode)
+        {
+            mode = newMode;
+            anchorValid = false;
+            for (auto& countdown : samplesUntilNextGrain)
+                countdown = 0;
+            for (auto& priming : needsPriming)
+                priming = mode != Normal;
+        }
+    }
+
+    // Divides the overlap of the freeze and scatter grains. Reverse always keeps two
+    // grains so its windows still sum flat. Takes effect from the next grain spawned.
+    void setDensityDivider (int newDivider)
+    {
+        densityDivider = std::max (1, newDivider);
+    }
+
+    int getMode() const      { return mode; }
+    bool isActive() const    { return mode != Normal || numActiveGrains > 0; }
+
+    //==============================================================================
+    // Renders numSamples (<= maxChunkSize) of grains into output, overwriting it.
+    // writeHead is the buffer position the caller is about to write for the first
+    // sample of this chunk; grains never read at or ahead of it.
+    void process (const float* const* delayBuffers, int writeHead, int delaySamples,
+                  float* const* output, int numSamples)
+    {
+        assert (numSamples <= maxChunkSize);
+
+        if (mode == Freeze && ! anchorValid)
+        {
+            freezeAnchor = writeHead;
+            anchorValid = true;
+        }
+
+        numActiveGrains = 0;
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            spawnGrains (channel, writeHead, delaySamples, numSamples);
+
+            float* out = output[channel];
+            std::fill (out, out + numSamples, 0.0f);
+
+            for (auto& grain : grains[channel])
+            {
+                if (! grain.active)
+                    continue;
+
+                renderGrain (grain, delayBuffers[channel], out, numSamples);
+                if (grain.active)
+                    ++numActiveGrains;
+            }
+        }
+    }
+
+private:
+    struct Grain
+    {
+        bool active = false;
+        int readPosition = 0;
+        int direction = 1;
+        int age = 0;
+        int startOffset = 0;
+        float gain = 1.0f;
+        const std::vector<float>* window = nullptr;
+    };
+
+    static void fillHannWindow (std::vector<float>& window, int length)
+    {
+        const float twoPi = 6.283185307179586f;
+        window.resize ((size_t) std::max (2, length));
+        auto size = window.size();
+        for (size_t i = 0; i < size; ++i)
+            window[i] = 0.5f - 0.5f * std::cos (twoPi * (float) i / (float) size);
+    }
+
+    int wrap (int position) const
+    {
+        position %= bufferLength;
+        return position < 0 ? position + bufferLength : position;
+    }
+
+    // Small xorshift so the engine has no dependency for its scatter positions
+    float nextRandom()
+    {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return (float) (randomState >> 8) * (1.0f / 16777216.0f);
+    }
+
+    //==============================================================================
+    void spawnGrains (int channel, int writeHead, int delaySamples, int numSamples)
+    {
+        if (mode == Normal)
+            return;
+
+        auto& window = mode == Scatter ? shortWindow : longWindow;
+        const int grainLength = (int) window.size();
+        const int fullOverlap = mode == Reverse ? 2 : (mode == Freeze ? 8 : 32);
+        const int overlap = std::max (2, fullOverlap / densityDivider);
+        const int hop = std::max (1, grainLength / overlap);
+
+        // Evenly spaced reverse grains add in phase, and their Hann windows sum
+        // to overlap / 2. Freeze and scatter grains come from random positions,
+        // so they add by power instead, and a Hann window's mean square is 3/8.
+        const float gain = mode == Reverse ? 2.0f / (float) overlap
+                                           : std::sqrt (8.0f / (3.0f * (float) overlap));
+
+        // A fresh stream would take a whole grain to build up to level, which is a
+        // gap the 20 ms mode crossfade can't hide. So on entering a mode, the grains
+        // that would already be playing start mid-window at staggered ages.
+        if (needsPriming[channel])
+        {
+            needsPriming[channel] = false;
+            for (int age = grainLength - hop; age > 0; age -= hop)
+                startGrain (channel, window, gain, writeHead, delaySamples, 0, age);
+        }
+
+        int& countdown = samplesUntilNextGrain[channel];
+        while (countdown < numSamples)
+        {
+            startGrain (channel, window, gain, writeHead, delaySamples, countdown, 0);
+            countdown += hop;
+        }
+        countdown -= numSamples;
+    }
+
+    // age is how far into its window the grain starts, as if it had been
+    // spawned that many samples ago
+    void startGrain (int channel, const std::vector<float>& window, float gain,
+                     int writeHead, int delaySamples, int offset, int age)
+    {
+        // When the pool is full the grain is simply dropped
+        auto* grain = findFreeGrain (channel);
+        if (grain == nullptr)
+            return;
+
+        const int grainLength = (int) window.size();
+        grain->active = true;
+        grain->age = age;
+        grain->startOffset = offset;
+        grain->gain = gain;
+        grain->window = &window;
+
+        if (mode == Reverse)
+        {
+            // Read backwards from delaySamples behind the head; the oldest sample is
+            // read one grain later, so it must still be in the buffer by then
+            int distance = limitValue (maxChunkSize, bufferLength - 2 * grainLength - 1, delaySamples);
+            grain->readPosition = wrap (writeHead + offset - distance - 2 * age);
+            grain->direction = -1;
+        }
+        else if (mode == Freeze)
+        {
+            // The writes fading out after the anchor wrap round onto the oldest
+            // part of the buffer, so the region ends before it
+            int region = limitValue (grainLength, bufferLength - freezeWriteFadeLength - maxChunkSize - 1, delaySamples);
+            int start = freezeAnchor - region + (int) (nextRandom() * (float) (region - grainLength));
+            grain->readPosition = wrap (start + age);
+            grain->direction = 1;
+        }
+        else
+        {
+            // Forward grains keep a constant distance to the head, so any
+            // distance of at least one chunk only ever reads written samples
+            int spread = delaySamples / 2;
+            int distance = delaySamples + (int) (nextRandom() * (float) spread);
+            distance = limitValue (maxChunkSize, bufferLength - 1, distance);
+            grain->readPosition = wrap (writeHead + offset - distance);
+            grain->direction = 1;
+        }
+    }
+
+    Grain* findFreeGrain (int channel)
+    {
+        for (auto& grain : grains[channel])
+            if (! grain.active)
+                return &grain;
+        return nullptr;
+    }
+
+    // dest += src * window * gain, four samples at a time. This is written with
+    // intrinsics rather than left to the auto-vectoriser, which skips these loops
+    // at -O2. Vector and scalar paths multiply in the same order.
+    static void addWindowed (float* __restrict dest, const float* __restrict src,
+                             const float* __restrict window, float gain, int numSamples)
+    {
+        int i = 0;
+       #if EZDLAY_GRAIN_SSE
+        const __m128 g = _mm_set1_ps (gain);
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            __m128 windowed = _mm_mul_ps (_mm_mul_ps (_mm_loadu_ps (src + i), _mm_loadu_ps (window + i)), g);
+            _mm_storeu_ps (dest + i, _mm_add_ps (_mm_loadu_ps (dest + i), windowed));
+        }
+       #elif EZDLAY_GRAIN_NEON
+        const float32x4_t g = vdupq_n_f32 (gain);
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            float32x4_t windowed = vmulq_f32 (vmulq_f32 (vld1q_f32 (src + i), vld1q_f32 (window + i)), g);
+            vst1q_f32 (dest + i, vaddq_f32 (vld1q_f32 (dest + i), windowed));
+        }
+       #endif
+        for (; i < numSamples; ++i)
+            dest[i] += src[i] * window[i] * gain;
+    }
+
+    // Same as addWindowed, but src points at the first sample read and walks
+    // backwards through the buffer, so each group of four is loaded and reversed.
+    static void addWindowedReversed (float* __restrict dest, const float* __restrict src,
+                                     const float* __restrict window, float gain, int numSamples)
+    {
+        int i = 0;
+       #if EZDLAY_GRAIN_SSE
+        const __m128 g = _mm_set1_ps (gain);
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            __m128 backwards = _mm_loadu_ps (src - i - 3);
+            __m128 forwards = _mm_shuffle_ps (backwards, backwards, _MM_SHUFFLE (0, 1, 2, 3));
+            __m128 windowed = _mm_mul_ps (_mm_mul_ps (forwards, _mm_loadu_ps (window + i)), g);
+            _mm_storeu_ps (dest + i, _mm_add_ps (_mm_loadu_ps (dest + i), windowed));
+        }
+       #elif EZDLAY_GRAIN_NEON
+        const float32x4_t g = vdupq_n_f32 (gain);
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            float32x4_t backwards = vrev64q_f32 (vld1q_f32 (src - i - 3));
+            float32x4_t forwards = vcombine_f32 (vget_high_f32 (backwards), vget_low_f32 (backwards));
+            float32x4_t windowed = vmulq_f32 (vmulq_f32 (forwards, vld1q_f32 (window + i)), g);
+            vst1q_f32 (dest + i, vaddq_f32 (vld1q_f32 (dest + i), windowed));
+        }
+       #endif
+        for (; i < numSamples; ++i)
+            dest[i] += src[-i] * window[i] * gain;
+    }
+
+    // Works over contiguous runs of the delay buffer, split only where it wraps
+    void renderGrain (Grain& grain, const float* delayBuffer, float* out, int numSamples)
+    {
+        const auto& window = *grain.window;
+        const int grainLength = (int) window.size();
+        const int count = std::min (numSamples - grain.startOffset, grainLength - grain.age);
+        const float gain = grain.gain;
+        const float* windowData = window.data() + grain.age;
+        float* dest = out + grain.startOffset;
+
+        int position = grain.readPosition;
+        int done = 0;
+        while (done < count)
+        {
+            if (grain.direction > 0)
+            {
+                const int run = std::min (count - done, bufferLength - position);
+                addWindowed (dest + done, delayBuffer + position, windowData + done, gain, run);
+                done += run;
+                position = wrap (position + run);
+            }
+            else
+            {
+                const int run = std::min (count - done, position + 1);
+                addWindowedReversed (dest + done, delayBuffer + position, windowData + done, gain, run);
+                done += run;
+                position = wrap (position - run);
+            }
+        }
+        grain.readPosition = position;
+
+        grain.age += count;
+        grain.startOffset = 0;
+        if (grain.age >= grainLength)
+            grain.active = false;
+    }
+
+    //==============================================================================
+    std::array<std::array<Grain, maxGrains>, numChannels> grains;
+    std::array<int, numChannels> samplesUntilNextGrain {};
+    std::array<bool, numChannels> needsPriming {};
+
+    std::vector<float> longWindow;
+    std::vector<float> shortWindow;
+
+    uint32_t randomState = 0x9e3779b9;
+    int bufferLength = 1;
+    int mode = Normal;
+    int densityDivider = 1;
+    int numActiveGrains = 0;
+    int freezeWriteFadeLength = 0;
+    int freezeAnchor = 0;
+    bool anchorValid = false;
+};
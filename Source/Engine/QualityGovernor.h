@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    QualityGovernor.h
+    Created: 19 Oct 2026
+    Author:  David Jones
+
+    Measures how long each processed block takes against its real-time budget
+    and steps the delay between quality tiers so an overloaded live rig
+    degrades instead of dropping out. Offline bounces always run at High.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "DspUtils.h"
+
+//===================================================================================
+class QualityGovernor
+{
+public:
+    enum Tier
+    {
+        High = 0,   // cubic interpolation, cutoff glide every sample, full grain density
+        Medium,     // cubic interpolation, cutoff glide every 16 samples, half the grains
+        Low,        // linear interpolation, cutoff glide every 64 samples, a quarter of the grains
+        numTiers
+    };
+
+    // Values of the quality mode: Auto lets the governor decide,
+    // the rest pin the tier.
+    enum Mode
+    {
+        Auto = 0,
+        ForceHigh,
+        ForceMedium,
+        ForceLow,
+        numModes
+    };
+
+    static const char* const* getModeNames()
+    {
+        static const char* const names[numModes] = { "Auto", "High", "Medium", "Low" };
+        return names;
+    }
+    static const char* getTierName (int tier)  { return getModeNames()[limitValue (0, numTiers - 1, tier) + 1]; }
+
+    static bool usesCubicInterpolation (int tier)  { return tier != Low; }
+    static int getFilterUpdateInterval (int tier)
+    {
+        if (tier == High)   return 1;
+        if (tier == Medium) return 16;
+        return 64;
+    }
+    // Grain modes are the most expensive, so lower tiers divide their overlap
+    static int getGrainDensityDivider (int tier)
+    {
+        if (tier == High)   return 1;
+        if (tier == Medium) return 2;
+        return 4;
+    }
+
+    //==============================================================================
+    void prepare (double newSampleRate, int samplesPerBlock)
+    {
+        sampleRate = newSampleRate;
+        fadeLength = std::max (1, (int) (sampleRate * fadeTimeSeconds));
+        fadeRemaining = 0;
+
+        // Stepping up needs a couple of seconds of headroom, stepping down only a few blocks
+        blocksBeforeUpgrade = std::max (1, (int) (upgradeHoldSeconds * sampleRate / std::max (1, samplesPerBlock)));
+        overloadedBlocks = 0;
+        relaxedBlocks = 0;
+        smoothedLoad = 0;
+
+        currentTier = mode == Auto ? (int) High : mode - 1;
+        previousTier = currentTier.load();
+        lockToHighIfNonRealtime();
+    }
+
+    void setMode (int newMode)
+    {
+        mode = limitValue ((int) Auto, (int) ForceLow, newMode);
+    }
+
+    void setNonRealtime (bool shouldBeNonRealtime)
+    {
+        nonRealtime = shouldBeNonRealtime;
+    }
+
+    //==============================================================================
+    void blockStarted()
+    {
+        lockToHighIfNonRealtime();
+        startTime = Clock::now();
+    }
+
+    // Call once processing of the block is done. Any tier change takes effect
+    // from the next block, with a crossfade between the old and new tier.
+    void blockFinished (int numSamples)
+    {
+        if (numSamples <= 0 || sampleRate <= 0)
+            return;
+
+        std::chrono::duration<double> elapsed = Clock::now() - startTime;
+        auto budget = numSamples / sampleRate;
+        auto load = (float) (elapsed.count() / budget);
+        smoothedLoad = smoothedLoad + loadSmoothing * (load - smoothedLoad);
+        currentLoad = smoothedLoad;
+
+        int tier = currentTier.load();
+
+        if (nonRealtime)
+            return;
+        if (mode != Auto)
+        {
+            changeTier (mode - 1);
+            return;
+        }
+
+        // Hysteresis: a wide dead band between the two thresholds plus a hold
+        // count on each side keeps the tier from flapping around one load value.
+        if (smoothedLoad > downgradeLoad || load > 1.0f)
+        {
+            relaxedBlocks = 0;
+            if (++overloadedBlocks >= blocksBeforeDowngrade && tier < Low)
+                changeTier (tier + 1);
+        }
+        else if (smoothedLoad < upgradeLoad)
+        {
+            overloadedBlocks = 0;
+            if (++relaxedBlocks >= blocksBeforeUpgrade && tier > High)
+                changeTier (tier - 1);
+        }
+        else
+        {
+            overloadedBlocks = 0;
+            relaxedBlocks = 0;
+        }
+    }
+
+    //==============================================================================
+    int getTier() const           { return currentTier.load(); }
+    int getPreviousTier() const   { return previousTier.load(); }
+    float getLoad() const         { return currentLoad.load(); }
+    bool isFading() const         { return fadeRemaining > 0; }
+
+    // Gain for the current tier's output on this sample; the previous tier gets
+    // (1 - gain). Only call this while isFading() is true.
+    float getNextFadeGain()
+    {
+        --fadeRemaining;
+        return 1.0f - (float) fadeRemaining / (float) fadeLength;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Offline renders must not spend even one block below High, so this
+    // jumps straight there before processing instead of fading
+    void lockToHighIfNonRealtime()
+    {
+        if (! nonRealtime)
+            return;
+
+        currentTier = (int) High;
+        previousTier = (int) High;
+        fadeRemaining = 0;
+        overloadedBlocks = 0;
+        relaxedBlocks = 0;
+    }
+
+    void changeTier (int newTier)
+    {
+        overloadedBlocks = 0;
+        relaxedBlocks = 0;
+
+        // Let a running crossfade finish first so the previous tier stays valid
+        if (newTier == currentTier.load() || isFading())
+            return;
+
+        previousTier = currentTier.load();
+        currentTier = newTier;
+        fadeRemaining = fadeLength;
+    }
+
+    static constexpr float downgradeLoad = 0.8f;
+    static constexpr float upgradeLoad = 0.35f;
+    static constexpr float loadSmoothing = 0.1f;
+    static constexpr int blocksBeforeDowngrade = 4;
+    static constexpr double upgradeHoldSeconds = 2.0;
+    static constexpr double fadeTimeSeconds = 0.02;
+
+    double sampleRate = 0;
+    int mode = Auto;
+    bool nonRealtime = false;
+    Clock::time_point startTime;
+
+    std::atomic<int> currentTier { High };
+    std::atomic<int> previousTier { High };
+    std::atomic<float> currentLoad { 0 };
+    float smoothedLoad = 0;
+
+    int overloadedBlocks = 0;
+    int relaxedBlocks = 0;
+    int blocksBeforeUpgrade = 1;
+
+    int fadeLength = 1;
+    int fadeRemaining = 0;
+};
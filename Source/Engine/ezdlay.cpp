@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    ezdlay.cpp
+    Created: 19 Oct 2026
+    Author:  David Jones
+
+  ==============================================================================
+*/
+
+#include "ezdlay.h"
+#include "DelayEngine.h"
+
+#include <cmath>
+#include <new>
+
+static_assert (EZDLAY_MAX_DELAY_TIME_MS == (int) DelayEngine::maxDelayTimeMs, "C and C++ delay limits differ");
+
+struct ezdlay_engine
+{
+    DelayEngine engine;
+};
+
+ezdlay_engine* ezdlay_create (void)
+{
+    return new (std::nothrow) ezdlay_engine();
+}
+
+void ezdlay_destroy (ezdlay_engine* engine)
+{
+    delete engine;
+}
+
+int ezdlay_prepare (ezdlay_engine* engine, double sample_rate, int max_block_size)
+{
+    if (engine == nullptr || sample_rate <= 0)
+        return -1;
+
+    try
+    {
+        engine->engine.prepare (sample_rate, max_block_size);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+void ezdlay_reset (ezdlay_engine* engine)
+{
+    if (engine != nullptr)
+        engine->engine.reset();
+}
+
+void ezdlay_set_parameter (ezdlay_engine* engine, ezdlay_param param, float value)
+{
+    // NaN would pass straight through the range clamps and the int casts
+    if (engine == nullptr || ! std::isfinite (value))
+        return;
+
+    auto& e = engine->engine;
+    switch (param)
+    {
+        case EZDLAY_PARAM_DELAY_TIME:   e.setDelayTime (value); break;
+        case EZDLAY_PARAM_FEEDBACK:     e.setFeedback (value); break;
+        case EZDLAY_PARAM_MIX:          e.setMix (value); break;
+        case EZDLAY_PARAM_CUTOFF:       e.setCutoff (value); break;
+        case EZDLAY_PARAM_QUALITY:      e.setQualityMode ((int) value); break;
+        case EZDLAY_PARAM_MODE:         e.setMode ((int) value); break;
+        case EZDLAY_PARAM_NON_REALTIME: e.setNonRealtime (value != 0); break;
+        default: break;
+    }
+}
+
+int ezdlay_get_quality_tier (const ezdlay_engine* engine)
+{
+    return engine != nullptr ? engine->engine.getQualityTier() : 0;
+}
+
+float ezdlay_get_cpu_load (const ezdlay_engine* engine)
+{
+    return engine != nullptr ? engine->engine.getCpuLoad() : 0.0f;
+}
+
+int ezdlay_process_planar (ezdlay_engine* engine, const float* const* in, float* const* out,
+                           int num_channels, int num_frames)
+{
+    if (engine == nullptr || in == nullptr || out == nullptr || ! engine->engine.isPrepared())
+        return -1;
+
+    return engine->engine.processPlanar (in, out, num_channels, num_frames) ? 0 : -1;
+}
+
+int ezdlay_process_interleaved (ezdlay_engine* engine, const float* in, float* out,
+                                int num_channels, int num_frames)
+{
+    if (engine == nullptr || in == nullptr || out == nullptr || ! engine->engine.isPrepared())
+        return -1;
+
+    return engine->engine.processInterleaved (in, out, num_channels, num_frames) ? 0 : -1;
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    ezdlay.h
+    Created: 19 Oct 2026
+    Author:  David Jones
+
+    C interface to the EZ DLay engine, for embedding it in other audio
+    engines. All process calls work on caller-owned buffers, in place or
+    out of place, and never allocate. An engine must only be used from one
+    thread at a time; ezdlay_get_quality_tier and ezdlay_get_cpu_load are
+    the exception and may be polled from anywhere.
+
+  ==============================================================================
+*/
+
+#ifndef EZDLAY_H
+#define EZDLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EZDLAY_MAX_DELAY_TIME_MS 2000
+
+typedef struct ezdlay_engine ezdlay_engine;
+
+typedef enum
+{
+    EZDLAY_PARAM_DELAY_TIME = 0,    /* milliseconds, 0 - EZDLAY_MAX_DELAY_TIME_MS */
+    EZDLAY_PARAM_FEEDBACK,          /* 0 - 0.98 */
+    EZDLAY_PARAM_MIX,               /* 0 dry - 1 wet */
+    EZDLAY_PARAM_CUTOFF,            /* feedback lowpass, 20 - 20000 Hz */
+    EZDLAY_PARAM_QUALITY,           /* one of ezdlay_quality */
+    EZDLAY_PARAM_MODE,              /* one of ezdlay_mode */
+    EZDLAY_PARAM_NON_REALTIME       /* non-zero pins the quality to high, e.g. for offline renders */
+} ezdlay_param;
+
+typedef enum
+{
+    EZDLAY_QUALITY_AUTO = 0,
+    EZDLAY_QUALITY_HIGH,
+    EZDLAY_QUALITY_MEDIUM,
+    EZDLAY_QUALITY_LOW
+} ezdlay_quality;
+
+typedef enum
+{
+    EZDLAY_MODE_NORMAL = 0,
+    EZDLAY_MODE_REVERSE,
+    EZDLAY_MODE_FREEZE,
+    EZDLAY_MODE_SCATTER
+} ezdlay_mode;
+
+/* Returns NULL if the engine couldn't be allocated. */
+ezdlay_engine* ezdlay_create (void);
+void ezdlay_destroy (ezdlay_engine* engine);
+
+/* Allocates the delay line. Must be called before processing and whenever the
+   sample rate changes. Returns 0 on success. */
+int ezdlay_prepare (ezdlay_engine* engine, double sample_rate, int max_block_size);
+void ezdlay_reset (ezdlay_engine* engine);
+
+/* Values outside a parameter's range are clamped; NaN and infinity are ignored. */
+void ezdlay_set_parameter (ezdlay_engine* engine, ezdlay_param param, float value);
+
+/* The tier actually running: 0 high, 1 medium, 2 low. */
+int ezdlay_get_quality_tier (const ezdlay_engine* engine);
+/* Smoothed processing time as a fraction of the real-time budget. */
+float ezdlay_get_cpu_load (const ezdlay_engine* engine);
+
+/* num_channels must be 1 or 2. in and out may point to the same buffers for
+   in-place processing. Return 0 on success. */
+int ezdlay_process_planar (ezdlay_engine* engine, const float* const* in, float* const* out,
+                           int num_channels, int num_frames);
+int ezdlay_process_interleaved (ezdlay_engine* engine, const float* in, float* out,
+                                int num_channels, int num_frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
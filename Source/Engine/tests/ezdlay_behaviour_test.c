@@ -0,0 +1,298 @@
+/*
+  ==============================================================================
+
+    ezdlay_behaviour_test.c
+    Created: 19 Oct 2026
+    Author:  David Jones
+
+    Checks how the engine behaves over time: quality tier changes, the
+    offline lock and the grain modes. Everything goes through the C API.
+
+  ==============================================================================
+*/
+
+#include "ezdlay.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLE_RATE 48000
+#define BLOCK_SIZE  256
+
+static float block[2 * BLOCK_SIZE];
+static int failures = 0;
+static unsigned int noiseState = 1;
+
+static const char* const modeNames[] = { "normal", "reverse", "freeze", "scatter" };
+
+static void check (int condition, const char* description)
+{
+    if (! condition)
+    {
+        printf ("FAIL %s\n", description);
+        ++failures;
+    }
+}
+
+static ezdlay_engine* createEngine (void)
+{
+    ezdlay_engine* engine = ezdlay_create();
+    if (engine != NULL && ezdlay_prepare (engine, SAMPLE_RATE, BLOCK_SIZE) != 0)
+    {
+        ezdlay_destroy (engine);
+        engine = NULL;
+    }
+    return engine;
+}
+
+static void fillWithSilence (void)
+{
+    memset (block, 0, sizeof (block));
+}
+
+static void processBlocks (ezdlay_engine* engine, int numBlocks)
+{
+    for (int i = 0; i < numBlocks; ++i)
+        ezdlay_process_interleaved (engine, block, block, 2, BLOCK_SIZE);
+}
+
+// Uncorrelated noise, so crossfades don't cancel the way a pure tone can
+static void fillWithNoise (void)
+{
+    for (int i = 0; i < 2 * BLOCK_SIZE; ++i)
+    {
+        noiseState ^= noiseState << 13;
+        noiseState ^= noiseState >> 17;
+        noiseState ^= noiseState << 5;
+        block[i] = 0.5f * ((float) (noiseState / 4294967296.0) * 2.0f - 1.0f);
+    }
+}
+
+// RMS of the left channel of one processed block
+static float processBlockLevel (ezdlay_engine* engine)
+{
+    float sum = 0;
+    ezdlay_process_interleaved (engine, block, block, 2, BLOCK_SIZE);
+    for (int i = 0; i < BLOCK_SIZE; ++i)
+        sum += block[2 * i] * block[2 * i];
+    return sqrtf (sum / BLOCK_SIZE);
+}
+
+//==============================================================================
+// Forcing the tier must work in every mode, including the grain modes where
+// the interpolated read is unused
+static void testForcedTiers (void)
+{
+    char description[128];
+
+    for (int mode = EZDLAY_MODE_NORMAL; mode <= EZDLAY_MODE_SCATTER; ++mode)
+    {
+        ezdlay_engine* engine = createEngine();
+        check (engine != NULL, "engine created");
+        if (engine == NULL)
+            return;
+
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_MODE, (float) mode);
+        processBlocks (engine, 10);
+
+        static const int sequence[] = { EZDLAY_QUALITY_MEDIUM, EZDLAY_QUALITY_LOW, EZDLAY_QUALITY_HIGH, EZDLAY_QUALITY_LOW };
+        for (int i = 0; i < 4; ++i)
+        {
+            ezdlay_set_parameter (engine, EZDLAY_PARAM_QUALITY, (float) sequence[i]);
+
+            // A change lands after the block it was requested in, then the 20 ms crossfade runs
+            processBlocks (engine, 10);
+            snprintf (description, sizeof (description), "%s mode: forced quality %d runs tier %d, got %d",
+                      modeNames[mode], sequence[i], sequence[i] - 1, ezdlay_get_quality_tier (engine));
+            check (ezdlay_get_quality_tier (engine) == sequence[i] - 1, description);
+        }
+
+        ezdlay_destroy (engine);
+    }
+}
+
+// In Auto an idle engine climbs back one tier at a time, each only after the
+// upgrade hold, never jumping straight from Low to High
+static void testTierStepping (void)
+{
+    char description[128];
+
+    ezdlay_engine* engine = createEngine();
+    check (engine != NULL, "engine created");
+    if (engine == NULL)
+        return;
+
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_QUALITY, EZDLAY_QUALITY_LOW);
+    processBlocks (engine, 10);
+    check (ezdlay_get_quality_tier (engine) == 2, "forced low quality runs the low tier");
+
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_QUALITY, EZDLAY_QUALITY_AUTO);
+
+    // The hold is two seconds of blocks
+    const int blocksPerSecond = SAMPLE_RATE / BLOCK_SIZE;
+    int tier = ezdlay_get_quality_tier (engine);
+    int blocksSinceChange = 0;
+    for (int i = 0; i < 5 * blocksPerSecond; ++i)
+    {
+        processBlocks (engine, 1);
+        ++blocksSinceChange;
+
+        int newTier = ezdlay_get_quality_tier (engine);
+        if (newTier == tier)
+            continue;
+
+        snprintf (description, sizeof (description), "auto steps from tier %d to %d after %d blocks",
+                  tier, newTier, blocksSinceChange);
+        check (newTier == tier - 1 && blocksSinceChange >= blocksPerSecond, description);
+        tier = newTier;
+        blocksSinceChange = 0;
+    }
+
+    snprintf (description, sizeof (description), "auto is back at the high tier, got %d", tier);
+    check (tier == 0, description);
+
+    ezdlay_destroy (engine);
+}
+
+// Offline rendering runs at High from the first sample, whatever the quality setting
+static void testNonRealtimeLock (void)
+{
+    ezdlay_engine* engine = ezdlay_create();
+    check (engine != NULL, "engine created");
+    if (engine == NULL)
+        return;
+
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_QUALITY, EZDLAY_QUALITY_LOW);
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_NON_REALTIME, 1.0f);
+    check (ezdlay_prepare (engine, SAMPLE_RATE, BLOCK_SIZE) == 0, "engine prepared");
+    check (ezdlay_get_quality_tier (engine) == 0, "non-realtime starts at the high tier");
+
+    int stayedHigh = 1;
+    for (int i = 0; i < 50; ++i)
+    {
+        processBlocks (engine, 1);
+        stayedHigh = stayedHigh && ezdlay_get_quality_tier (engine) == 0;
+    }
+    check (stayedHigh, "non-realtime stays at the high tier with low quality forced");
+
+    // Going offline mid-stream takes effect from the very next block, without a fade
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_NON_REALTIME, 0.0f);
+    processBlocks (engine, 10);
+    check (ezdlay_get_quality_tier (engine) == 2, "realtime runs the forced low tier");
+
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_NON_REALTIME, 1.0f);
+    processBlocks (engine, 1);
+    check (ezdlay_get_quality_tier (engine) == 0, "switching to non-realtime jumps straight to the high tier");
+
+    ezdlay_destroy (engine);
+}
+
+// Freeze stops writing, so the frozen audio outlives the whole delay buffer,
+// while Normal runs dry once the last input has passed the read head
+static void testFreezeParksWriteHead (void)
+{
+    char description[128];
+    static const int modes[] = { EZDLAY_MODE_NORMAL, EZDLAY_MODE_FREEZE };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const int mode = modes[i];
+        ezdlay_engine* engine = createEngine();
+        check (engine != NULL, "engine created");
+        if (engine == NULL)
+            return;
+
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_MIX, 1.0f);
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_FEEDBACK, 0.0f);
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_DELAY_TIME, 500.0f);
+
+        const int blocksPerSecond = SAMPLE_RATE / BLOCK_SIZE;
+        float steadyLevel = 0;
+        for (int j = 0; j < blocksPerSecond; ++j)
+        {
+            fillWithNoise();
+            float level = processBlockLevel (engine);
+            if (j >= blocksPerSecond / 2)
+                steadyLevel += level / (blocksPerSecond - blocksPerSecond / 2);
+        }
+
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_MODE, (float) mode);
+
+        // Longer than the 2 s delay buffer, so anything still written would be gone
+        float finalLevel = 0;
+        for (int j = 0; j < 3 * blocksPerSecond; ++j)
+        {
+            fillWithSilence();
+            finalLevel = processBlockLevel (engine);
+        }
+
+        snprintf (description, sizeof (description), "%s mode: level after 3 s of silence %.3f, before %.3f",
+                  modeNames[mode], finalLevel, steadyLevel);
+        if (mode == EZDLAY_MODE_FREEZE)
+            check (finalLevel > 0.25f * steadyLevel, description);
+        else
+            check (finalLevel < 1.0e-4f, description);
+
+        ezdlay_destroy (engine);
+    }
+}
+
+// Switching out of Normal must not leave a gap while the grains build up
+static void testModeEntryLevel (void)
+{
+    char description[128];
+
+    for (int mode = EZDLAY_MODE_REVERSE; mode <= EZDLAY_MODE_SCATTER; ++mode)
+    {
+        ezdlay_engine* engine = createEngine();
+        check (engine != NULL, "engine created");
+        if (engine == NULL)
+            return;
+
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_MIX, 1.0f);
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_FEEDBACK, 0.0f);
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_NON_REALTIME, 1.0f);
+
+        float steadyLevel = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            fillWithNoise();
+            float level = processBlockLevel (engine);
+            if (i >= 50)
+                steadyLevel += level / 50;
+        }
+
+        ezdlay_set_parameter (engine, EZDLAY_PARAM_MODE, (float) mode);
+
+        // Covers the crossfade and the first grain lengths of the new mode
+        float lowestLevel = steadyLevel;
+        for (int i = 0; i < 60; ++i)
+        {
+            fillWithNoise();
+            float level = processBlockLevel (engine);
+            if (level < lowestLevel)
+                lowestLevel = level;
+        }
+
+        snprintf (description, sizeof (description), "%s mode: level after switching %.3f, steady %.3f",
+                  modeNames[mode], lowestLevel, steadyLevel);
+        check (lowestLevel > 0.5f * steadyLevel, description);
+
+        ezdlay_destroy (engine);
+    }
+}
+
+int main (void)
+{
+    testForcedTiers();
+    testTierStepping();
+    testNonRealtimeLock();
+    testFreezeParksWriteHead();
+    testModeEntryLevel();
+
+    if (failures == 0)
+        printf ("All behaviour checks passed\n");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    ezdlay_test.c
+    Created: 19 Oct 2026
+    Author:  David Jones
+
+    Runs the same input through the planar and interleaved entry points,
+    in place and out of place, and checks all four give bit-identical
+    output in every mode, for mono and stereo, at a normal delay time and
+    while gliding down to no delay at all.
+
+  ==============================================================================
+*/
+
+#include "ezdlay.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLE_RATE 48000
+#define NUM_FRAMES  (SAMPLE_RATE * 2)
+#define MAX_BLOCK   700
+
+enum { PLANAR_OUT_OF_PLACE, PLANAR_IN_PLACE, INTERLEAVED_OUT_OF_PLACE, INTERLEAVED_IN_PLACE, NUM_PATHS };
+
+static const char* const pathNames[NUM_PATHS] =
+{
+    "planar out of place", "planar in place", "interleaved out of place", "interleaved in place"
+};
+
+static float input[2][NUM_FRAMES];
+static float output[NUM_PATHS][2][NUM_FRAMES];
+static float interleavedIn[2 * MAX_BLOCK];
+static float interleavedOut[2 * MAX_BLOCK];
+
+static void fillInput (void)
+{
+    unsigned int state = 12345;
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < NUM_FRAMES; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            input[channel][i] = ((float) (state >> 8) / 16777216.0f - 0.5f) * 0.5f;
+        }
+}
+
+static ezdlay_engine* createEngine (void)
+{
+    ezdlay_engine* engine = ezdlay_create();
+    if (engine == NULL)
+        return NULL;
+
+    /* Non-realtime pins the quality tier, so timing can't make the paths differ */
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_NON_REALTIME, 1);
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_DELAY_TIME, 150);
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_FEEDBACK, 0.6f);
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_MIX, 0.7f);
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_CUTOFF, 6000);
+    ezdlay_set_parameter (engine, EZDLAY_PARAM_MODE, EZDLAY_MODE_NORMAL);
+
+    if (ezdlay_prepare (engine, SAMPLE_RATE, MAX_BLOCK) != 0)
+    {
+        ezdlay_destroy (engine);
+        return NULL;
+    }
+
+    return engine;
+}
+
+static int runPath (int path, int mode, int numChannels, float delayTime)
+{
+    ezdlay_engine* engine = createEngine();
+    if (engine == NULL)
+        return 0;
+
+    float (*out)[NUM_FRAMES] = output[path];
+    int start = 0;
+    int blockIndex = 0;
+    int ok = 1;
+
+    if (path == PLANAR_IN_PLACE)
+        for (int channel = 0; channel < numChannels; ++channel)
+            memcpy (out[channel], input[channel], sizeof (input[channel]));
+
+    while (start < NUM_FRAMES && ok)
+    {
+        /* Freeze needs something in the buffer first, so the mode is switched in later.
+           The delay time changes at the same point, so it glides from 150 ms. */
+        if (start >= NUM_FRAMES / 4)
+        {
+            ezdlay_set_parameter (engine, EZDLAY_PARAM_MODE, (float) mode);
+            ezdlay_set_parameter (engine, EZDLAY_PARAM_DELAY_TIME, delayTime);
+        }
+
+        /* Uneven block sizes so grain chunks and buffer wraps land everywhere */
+        int numFrames = 1 + (blockIndex * 193) % MAX_BLOCK;
+        if (numFrames > NUM_FRAMES - start)
+            numFrames = NUM_FRAMES - start;
+
+        if (path == PLANAR_OUT_OF_PLACE || path == PLANAR_IN_PLACE)
+        {
+            const float* in[2];
+            float* dest[2];
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                in[channel] = (path == PLANAR_IN_PLACE ? out[channel] : input[channel]) + start;
+                dest[channel] = out[channel] + start;
+            }
+            ok = ezdlay_process_planar (engine, in, dest, numChannels, numFrames) == 0;
+        }
+        else
+        {
+            for (int i = 0; i < numFrames; ++i)
+                for (int channel = 0; channel < numChannels; ++channel)
+                    interleavedIn[i * numChannels + channel] = input[channel][start + i];
+
+            float* dest = path == INTERLEAVED_IN_PLACE ? interleavedIn : interleavedOut;
+            ok = ezdlay_process_interleaved (engine, interleavedIn, dest, numChannels, numFrames) == 0;
+
+            for (int i = 0; i < numFrames; ++i)
+                for (int channel = 0; channel < numChannels; ++channel)
+                    out[channel][start + i] = dest[i * numChannels + channel];
+        }
+
+        start += numFrames;
+        ++blockIndex;
+    }
+
+    ezdlay_destroy (engine);
+    return ok;
+}
+
+int main (void)
+{
+    static const char* const modeNames[] = { "normal", "reverse", "freeze", "scatter" };
+    static const float delayTimes[] = { 150.0f, 0.0f };
+    int failures = 0;
+
+    fillInput();
+
+    for (int delayIndex = 0; delayIndex < 2; ++delayIndex)
+    {
+        const float delayTime = delayTimes[delayIndex];
+
+        for (int numChannels = 1; numChannels <= 2; ++numChannels)
+        {
+            for (int mode = EZDLAY_MODE_NORMAL; mode <= EZDLAY_MODE_SCATTER; ++mode)
+            {
+                for (int path = 0; path < NUM_PATHS; ++path)
+                {
+                    if (! runPath (path, mode, numChannels, delayTime))
+                    {
+                        printf ("FAIL %s, %g ms, %d channel(s): %s returned an error\n",
+                                modeNames[mode], delayTime, numChannels, pathNames[path]);
+                        ++failures;
+                    }
+                }
+
+                /* Guard against every path trivially agreeing on silence or the dry signal */
+                if (memcmp (output[0][0] + NUM_FRAMES / 2, input[0] + NUM_FRAMES / 2, sizeof (float) * NUM_FRAMES / 2) == 0)
+                {
+                    printf ("FAIL %s, %g ms, %d channel(s): output is the unprocessed input\n", modeNames[mode], delayTime, numChannels);
+                    ++failures;
+                }
+
+                for (int path = 1; path < NUM_PATHS; ++path)
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        if (memcmp (output[path][channel], output[0][channel], sizeof (output[0][channel])) != 0)
+                        {
+                            printf ("FAIL %s, %g ms, %d channel(s): %s differs from %s on channel %d\n",
+                                    modeNames[mode], delayTime, numChannels, pathNames[path], pathNames[0], channel);
+                            ++failures;
+                        }
+            }
+        }
+    }
+
+    /* Non-finite parameter values are ignored rather than reaching the engine */
+    {
+        ezdlay_engine* engine = createEngine();
+        static const ezdlay_param params[] = { EZDLAY_PARAM_DELAY_TIME, EZDLAY_PARAM_FEEDBACK, EZDLAY_PARAM_MIX, EZDLAY_PARAM_CUTOFF };
+        for (int i = 0; engine != NULL && i < 4; ++i)
+        {
+            ezdlay_set_parameter (engine, params[i], NAN);
+            ezdlay_set_parameter (engine, params[i], INFINITY);
+        }
+
+        const float* in[2] = { input[0], input[1] };
+        float* dest[2] = { output[0][0], output[0][1] };
+        int finite = engine != NULL && ezdlay_process_planar (engine, in, dest, 2, MAX_BLOCK) == 0;
+        for (int i = 0; finite && i < MAX_BLOCK; ++i)
+            finite = isfinite (dest[0][i]) && isfinite (dest[1][i]);
+
+        if (! finite)
+        {
+            printf ("FAIL non-finite parameter values reached the output\n");
+            ++failures;
+        }
+        ezdlay_destroy (engine);
+    }
+
+    /* Anything other than mono or stereo is rejected */
+    {
+        ezdlay_engine* engine = createEngine();
+        const float* in[3] = { input[0], input[1], input[0] };
+        float* dest[3] = { output[0][0], output[0][1], output[1][0] };
+        if (engine == NULL || ezdlay_process_planar (engine, in, dest, 3, 16) == 0)
+        {
+            printf ("FAIL three channels were accepted\n");
+            ++failures;
+        }
+        ezdlay_destroy (engine);
+    }
+
+    if (failures == 0)
+        printf ("All processing paths match\n");
+
+    return failures == 0 ? 0 : 1;
+}
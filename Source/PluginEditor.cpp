@@ -15,7 +15,7 @@ EZDLayAudioProcessorEditor::EZDLayAudioProcessorEditor (EZDLayAudioProcessor& p)
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
     setLookAndFeel(&otherLookAndFeel);
-    setSize(350, 360);
+    setSize(350, 390);
     Timer::startTimerHz(20);
 
     feedbackSlider.setLookAndFeel(&otherLookAndFeel);
@@ -28,6 +28,14 @@ EZDLayAudioProcessorEditor::EZDLayAudioProcessorEditor (EZDLayAudioProcessor& p)
     delayTimeAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, "DELAYTIME", delayTimeSlider);
     lowpassAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, "CUTOFF", lowpassFreqSlider);
     mixAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, "MIX", mixSlider);
+    
+    // Items have to be added before the attachment so it can select the current one
+    qualityBox.addItemList(StringArray(QualityGovernor::getModeNames(), QualityGovernor::numModes), 1);
+    addAndMakeVisible(qualityBox);
+    qualityAttachment = std::make_unique<AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "QUALITY", qualityBox);
+    modeBox.addItemList(StringArray(GrainScheduler::getModeNames(), GrainScheduler::numModes), 1);
+    addAndMakeVisible(modeBox);
+    modeAttachment = std::make_unique<AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "MODE", modeBox);
 
     
     setSliderParametersDial(feedbackSlider);
@@ -72,6 +80,7 @@ void EZDLayAudioProcessorEditor::paint (juce::Graphics& g)
     drawRotarySlider(g, delayTimeSlider.getX(), delayTimeSlider.getBottom() + distanceBetweenSlidersVertical, sliderWidthAndHeight, sliderWidthAndHeight, sliderPosFeedback , 4 * pi / 3, 8 * pi /3, feedbackSlider, String("Feedback"));
     drawRotarySlider(g, mixSlider.getX(), feedbackSlider.getY(), sliderWidthAndHeight, sliderWidthAndHeight, sliderPosLowpass, 4 * pi / 3, 8 * pi /3, lowpassFreqSlider, String("Cutoff Freq"));
     drawParamText(g);
+    drawQualityText(g);
 
 }
 
@@ -83,6 +92,8 @@ void EZDLayAudioProcessorEditor::resized()
     delayTimeSlider.setBounds(mixSlider.getRight() + horizontalDistance, column1Y, sliderWidthAndHeight, sliderWidthAndHeight);
     feedbackSlider.setBounds(delayTimeSlider.getX(), delayTimeSlider.getBottom() + distanceBetweenSlidersVertical, sliderWidthAndHeight, sliderWidthAndHeight);
     lowpassFreqSlider.setBounds(mixSlider.getX(), feedbackSlider.getY(), sliderWidthAndHeight, sliderWidthAndHeight);
+    qualityBox.setBounds(delayTimeSlider.getX(), getHeight() - 35, sliderWidthAndHeight, 25);
+    modeBox.setBounds(getWidth() - sliderWidthAndHeight - 5, 70, sliderWidthAndHeight, 20);
 }
 
 void EZDLayAudioProcessorEditor::drawParamText(Graphics &g)
@@ -116,6 +127,16 @@ void EZDLayAudioProcessorEditor::drawParamText(Graphics &g)
     g.setOpacity(.5);
     g.drawRoundedRectangle(textRect, 10, 2);
 }
+void EZDLayAudioProcessorEditor::drawQualityText(Graphics &g)
+{
+    // Shows the tier the governor is actually running, which may be below the one selected
+    auto tier = audioProcessor.getQualityTier();
+    auto load = roundToInt(audioProcessor.getCpuLoad() * 100);
+    auto text = String("Quality: " + String(QualityGovernor::getTierName(tier)) + " (" + String(load) + "%)");
+    g.setFont(16.0f);
+    g.setColour(tier == QualityGovernor::High ? Colours::white : Colours::orange);
+    g.drawFittedText(text, row1X, getHeight() - 35, sliderWidthAndHeight + horizontalDistance, 25, Justification::centredLeft, 1);
+}
 void EZDLayAudioProcessorEditor::timerCallback()
 {
     repaint();
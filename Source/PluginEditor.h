@@ -148,6 +148,7 @@ public:
     
     }
     void drawParamText(Graphics& g);
+    void drawQualityText(Graphics& g);
     void timerCallback() override;
     
 private:
@@ -160,11 +161,15 @@ private:
     Slider delayTimeSlider;
     Slider lowpassFreqSlider;
     Slider mixSlider;
+    ComboBox qualityBox;
+    ComboBox modeBox;
     
     std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> feedbackAttachment;
     std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> delayTimeAttachment;
     std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> lowpassAttachment;
     std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> mixAttachment;
+    std::unique_ptr<AudioProcessorValueTreeState::ComboBoxAttachment> qualityAttachment;
+    std::unique_ptr<AudioProcessorValueTreeState::ComboBoxAttachment> modeAttachment;
 
     const float pi = MathConstants<const float>::pi;
     int sliderWidthAndHeight = 100;
@@ -27,38 +27,17 @@ apvts(*this,
 std::make_unique<AudioParameterFloat>(ParameterID("FEEDBACK", 1), "Feedback", NormalisableRange<float> { 0.0f, .98f, .001f }, 0.5f),
 std::make_unique<AudioParameterFloat>(ParameterID("DELAYTIME",1), "Delay Time", NormalisableRange<float> { 0.0f, MAX_DELAY_TIME, 0.1f }, 200.0f) ,
 std::make_unique<AudioParameterFloat>(ParameterID("MIX",1), "Mix", NormalisableRange<float> { 0.0f, 1.0f, .001f }, 0.5f),
-std::make_unique<AudioParameterFloat>(ParameterID("CUTOFF",1), "Filter Cutoff Freq", NormalisableRange<float> { 20.0f, 20000.0f, .1f }, 20000.0f)
+std::make_unique<AudioParameterFloat>(ParameterID("CUTOFF",1), "Filter Cutoff Freq", NormalisableRange<float> { 20.0f, 20000.0f, .1f }, 20000.0f),
+std::make_unique<AudioParameterChoice>(ParameterID("QUALITY",1), "Quality", StringArray(QualityGovernor::getModeNames(), QualityGovernor::numModes), QualityGovernor::Auto),
+std::make_unique<AudioParameterChoice>(ParameterID("MODE",1), "Mode", StringArray(GrainScheduler::getModeNames(), GrainScheduler::numModes), GrainScheduler::Normal)
 }
                )
 #endif
 {
-    delayBufferRight = nullptr;
-    delayBufferLeft = nullptr;
-    
-    bufferWriteHead = 0;
-    bufferLength = 0;
-    bufferLength = 0;
-    
-    delayTimeSamples = 0;
-    delayReadHead = 0;
-    delayTimeSmoothed = 0;
-    
-    feedbackLeft = 0;
-    feedbackRight = 0;
 }
 
 EZDLayAudioProcessor::~EZDLayAudioProcessor()
 {
-    if (delayBufferRight != nullptr)
-    {
-        delete [] delayBufferRight;
-        delayBufferRight = nullptr;
-    }
-    if (delayBufferLeft != nullptr)
-    {
-        delete [] delayBufferLeft;
-        delayBufferLeft = nullptr;
-    }
 }
 
 //==============================================================================
@@ -128,32 +107,9 @@ void EZDLayAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
-    filterL.reset();
-    filterR.reset();
-    
-    filterL.setCoefficients(IIRCoefficients::makeLowPass(sampleRate, 20000));
-    filterR.setCoefficients(IIRCoefficients::makeLowPass(sampleRate, 20000));
-    
-    bufferLength = sampleRate * (MAX_DELAY_TIME / 1000);
-    delayTimeSamples = sampleRate * (*apvts.getRawParameterValue("DELAYTIME")/1000);
-    if (delayBufferLeft == nullptr)
-        {
-            delete [] delayBufferLeft;
-            delayBufferLeft = new float[bufferLength];
-        }
-    zeromem(delayBufferLeft, bufferLength * sizeof(float));
-    
-    if (delayBufferRight == nullptr)
-        {
-            delete [] delayBufferRight;
-            delayBufferRight = new float[bufferLength];
-        }
-
-    // Clear the buffers after instantiating!
-    zeromem(delayBufferRight, bufferLength * sizeof(float));
-
-    bufferWriteHead = 0;
-    delayTimeSmoothed = (*apvts.getRawParameterValue("DELAYTIME")/1000);
+    updateEngineParameters();
+    engine.setNonRealtime(isNonRealtime());
+    engine.prepare(sampleRate, samplesPerBlock);
 }
 
 void EZDLayAudioProcessor::releaseResources()
@@ -190,60 +146,29 @@ bool EZDLayAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
 
 void EZDLayAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
+    // No ScopedNoDenormals here, the engine flushes denormals itself
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     
-    auto& dTime = *apvts.getRawParameterValue("DELAYTIME");
-    auto& fBack = *apvts.getRawParameterValue("FEEDBACK");
-    auto& mix = *apvts.getRawParameterValue("MIX");
-    auto& cutoff = *apvts.getRawParameterValue("CUTOFF");
-    
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    float* leftBuffer = buffer.getWritePointer(0);
-    float* rightBuffer = buffer.getWritePointer(1);
-    for (int sample = 0; sample < buffer.getNumSamples(); sample++)
-    {
-        filterL.setCoefficients(IIRCoefficients::makeLowPass(getSampleRate(), cutoff));
-        filterR.setCoefficients(IIRCoefficients::makeLowPass(getSampleRate(), cutoff));
-        
-        delayTimeSmoothed = delayTimeSmoothed - .0001 * (delayTimeSmoothed - (dTime/1000));
-        delayTimeSamples = getSampleRate() * delayTimeSmoothed;
-        
-        delayBufferRight[bufferWriteHead] = rightBuffer[sample] + feedbackRight;
-        delayBufferLeft[bufferWriteHead] = leftBuffer[sample] + feedbackLeft;
-
-        
-        delayReadHead = bufferWriteHead - delayTimeSamples;
-        
-        if (delayReadHead < 0)
-            delayReadHead += bufferLength;
-        
-        int readHeadInt = (int) delayReadHead;
-        int readHeadInt1 = readHeadInt + 1;
-        float readHeadFloat = delayReadHead - readHeadInt;
-        
-        if (readHeadInt1 >= bufferLength)
-            readHeadInt1 -= bufferLength;
-        
-        float delaySampleLeft = lerp(delayBufferLeft[readHeadInt], delayBufferLeft[readHeadInt1], readHeadFloat);
-        float delaySampleRight = lerp(delayBufferRight[readHeadInt], delayBufferRight[readHeadInt1], readHeadFloat);
-        float delaySampleLowPassL = filterL.processSingleSampleRaw(delaySampleLeft);
-        float delaySampleLowPassR = filterR.processSingleSampleRaw(delaySampleRight);
-
-        feedbackLeft = fBack * delaySampleLowPassL;
-        feedbackRight = fBack * delaySampleLowPassR;
-        
-        bufferWriteHead++;
-        
-        buffer.setSample(0, sample, buffer.getSample(0, sample) * (1-mix) + delaySampleLowPassL * mix);
-        buffer.setSample(1, sample, buffer.getSample(1, sample) * (1-mix) + delaySampleLowPassR * mix);
+    updateEngineParameters();
+    engine.setNonRealtime(isNonRealtime());
+    
+    // In place on the host's buffer, no copies
+    engine.processPlanar(buffer.getArrayOfReadPointers(), buffer.getArrayOfWritePointers(),
+                         jmin(2, buffer.getNumChannels()), buffer.getNumSamples());
+}
 
-        if (bufferWriteHead >= bufferLength)
-            bufferWriteHead = 0;
-        }
+void EZDLayAudioProcessor::updateEngineParameters()
+{
+    engine.setDelayTime(*apvts.getRawParameterValue("DELAYTIME"));
+    engine.setFeedback(*apvts.getRawParameterValue("FEEDBACK"));
+    engine.setMix(*apvts.getRawParameterValue("MIX"));
+    engine.setCutoff(*apvts.getRawParameterValue("CUTOFF"));
+    engine.setQualityMode((int) *apvts.getRawParameterValue("QUALITY"));
+    engine.setMode((int) *apvts.getRawParameterValue("MODE"));
 }
 
 //==============================================================================
@@ -277,12 +202,4 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new EZDLayAudioProcessor();
 }
-  //============//
- //MY FUNCTIONS//
-//============//
-
-float EZDLayAudioProcessor::lerp(float sample1, float sample2, float inPhase)
-{
-    return (1 - inPhase) * sample1 + inPhase * sample2;
-}
 
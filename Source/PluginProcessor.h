@@ -9,8 +9,8 @@
 #pragma once
 
 #include <JuceHeader.h>
-#define MAX_DELAY_TIME 2000
-#include <math.h>
+#include "Engine/DelayEngine.h"
+#define MAX_DELAY_TIME DelayEngine::maxDelayTimeMs
 //==============================================================================
 /**
 */
@@ -24,18 +24,8 @@ class EZDLayAudioProcessor  :   public AudioProcessor
                             #endif
 {
 private:
-    float delayTimeSmoothed;
-    float feedbackRight;
-    float feedbackLeft;
-    float *delayBufferRight;
-    float *delayBufferLeft;
-    int bufferWriteHead;
-    int bufferLength;
-    float delayTimeSamples;
-    float delayReadHead;
-    
-    IIRFilter filterL;
-    IIRFilter filterR;
+    // All the DSP lives in the engine so it can be shared with non-JUCE hosts
+    DelayEngine engine;
 public:
     //==============================================================================
     EZDLayAudioProcessor();
@@ -74,7 +64,9 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
     //==============================================================================
-    float lerp (float sample1, float sample2, float inPhase);
+    int getQualityTier() const { return engine.getQualityTier(); }
+    float getCpuLoad() const { return engine.getCpuLoad(); }
+    void updateEngineParameters();
     AudioProcessorValueTreeState apvts;
     AudioProcessorValueTreeState::ParameterLayout createParams();
     